@@ -3,22 +3,41 @@
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fnmatch.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #define MAX_NAME 64
 #define MAX_INPUT 128
 #define MAX_PATH_LEN 1024
+#define MAX_ARGS (MAX_INPUT / 2)
+#define MEM_PRESSURE_PCT 90
 
+// The name is allocated inline at its exact length rather than MAX_NAME bytes
 typedef struct Node {
-    char name[MAX_NAME];
     bool isDirectory;
     struct Node* parent;
     struct Node* child;
     struct Node* sibling;
+    char name[];
 } Node;
 
+typedef struct MemStat {
+    size_t directories;
+    size_t files;
+    size_t bytes;
+} MemStat;
+
 Node* root;
 Node* cwd;
 bool verbose = false;
+size_t memUsed = 0;     // bytes held by all live nodes
+size_t memLimit = 0;    // global budget in bytes, 0 means unlimited
+bool memExceeded = false; // the last createNode was refused by the budget
+bool memTrimmed = false; // pressure relief already ran since usage last dropped
 
 // Trim leading and trailing whitespace from a string
 char* trim(char* str) {
@@ -62,7 +81,29 @@ void normalizeName(char* name) {
     name[MAX_NAME - 1] = '\0';
 }
 
+size_t nodeBytes(const Node* node) {
+    return sizeof(Node) + strlen(node->name) + 1;
+}
+
+// True once used reaches MEM_PRESSURE_PCT of the budget, computed without overflow
+bool memUnderPressure(size_t used) {
+    if (!memLimit) return false;
+    size_t threshold = memLimit / 100 * MEM_PRESSURE_PCT + memLimit % 100 * MEM_PRESSURE_PCT / 100;
+    return used >= threshold;
+}
+
+// Hand freed heap pages back to the system once usage nears the budget
+void relieveMemoryPressure() {
+    if (memTrimmed) return;
+    memTrimmed = true;
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    if (verbose) printf("Memory pressure: %zu of %zu bytes used, trimmed heap.\n", memUsed, memLimit);
+}
+
 Node* createNode(const char* name, bool isDirectory) {
+    memExceeded = false;
     char normalizedName[MAX_NAME];
     strncpy(normalizedName, name, MAX_NAME - 1);
     normalizedName[MAX_NAME - 1] = '\0';
@@ -75,13 +116,23 @@ Node* createNode(const char* name, bool isDirectory) {
         printf("Invalid name: %s (too long after normalization)\n", name);
         return NULL;
     }
-    Node* node = (Node*)malloc(sizeof(Node));
+    size_t len = strlen(normalizedName);
+    size_t bytes = sizeof(Node) + len + 1;
+    if (memLimit) {
+        if (bytes > memLimit || memUsed > memLimit - bytes) {
+            printf("Error: Memory budget exceeded (%zu of %zu bytes used).\n", memUsed, memLimit);
+            memExceeded = true;
+            return NULL;
+        }
+        if (memUnderPressure(memUsed + bytes)) relieveMemoryPressure();
+    }
+    Node* node = (Node*)malloc(bytes);
     if (!node) {
         printf("Memory allocation failed.\n");
         return NULL;
     }
-    strncpy(node->name, normalizedName, MAX_NAME - 1);
-    node->name[MAX_NAME - 1] = '\0';
+    memcpy(node->name, normalizedName, len + 1);
+    memUsed += bytes;
     node->isDirectory = isDirectory;
     node->parent = NULL;
     node->child = NULL;
@@ -89,19 +140,22 @@ Node* createNode(const char* name, bool isDirectory) {
     return node;
 }
 
-void insertChild(Node* parent, Node* child) {
+// Link child after tail, the last child of parent (NULL when parent has none)
+void appendChild(Node* parent, Node* tail, Node* child) {
     if (!parent || !child) return;
-    if (!parent->child) {
-        parent->child = child;
-    } else {
-        Node* temp = parent->child;
-        while (temp->sibling) temp = temp->sibling;
-        temp->sibling = child;
-    }
+    if (tail) tail->sibling = child;
+    else parent->child = child;
     child->parent = parent;
     if (verbose) printf("Inserted %s as child of %s\n", child->name, parent->name);
 }
 
+void insertChild(Node* parent, Node* child) {
+    if (!parent || !child) return;
+    Node* tail = parent->child;
+    while (tail && tail->sibling) tail = tail->sibling;
+    appendChild(parent, tail, child);
+}
+
 Node* findChild(Node* parent, const char* name) {
     if (!parent || !name) {
         if (verbose) printf("findChild: Parent or name is NULL\n");
@@ -121,11 +175,27 @@ Node* findChild(Node* parent, const char* name) {
     return NULL;
 }
 
+void destroyNode(Node* node) {
+    if (!node) return;
+    memUsed -= nodeBytes(node);
+    if (memLimit && !memUnderPressure(memUsed)) memTrimmed = false;
+    free(node);
+}
+
 void freeTree(Node* node) {
     if (!node) return;
     freeTree(node->child);
     freeTree(node->sibling);
-    free(node);
+    destroyNode(node);
+}
+
+// Accumulate node counts and bytes for node and all of its descendants
+void measureSubtree(const Node* node, MemStat* stat) {
+    if (!node) return;
+    if (node->isDirectory) stat->directories++;
+    else stat->files++;
+    stat->bytes += nodeBytes(node);
+    for (const Node* temp = node->child; temp; temp = temp->sibling) measureSubtree(temp, stat);
 }
 
 void pwd(Node* node, bool inlinePrompt) {
@@ -222,100 +292,163 @@ Node* findNodeFromPath(Node* start, const char* path) {
     return target;
 }
 
-void mkdir(const char* name) {
-    if (!name || strlen(name) == 0) {
-        printf("Error: Directory name is empty.\n");
-        return;
-    }
-    if (findChild(cwd, name)) {
-        printf("Directory already exists.\n");
-        return;
-    }
-    Node* newDir = createNode(name, true);
-    if (newDir) {
-        insertChild(cwd, newDir);
-        if (verbose) printf("Created directory: %s\n", name);
+// Split a command argument into whitespace-separated names (modifies buf)
+int splitNames(char* buf, char* names[], int maxNames) {
+    int count = 0;
+    char* token = strtok(buf, " \t");
+    while (token && count < maxNames) {
+        names[count++] = token;
+        token = strtok(NULL, " \t");
     }
+    return count;
 }
 
-void createFile(const char* name) {
-    if (!name || strlen(name) == 0) {
-        printf("Error: File name is empty.\n");
+// A name containing glob metacharacters is matched with fnmatch instead of strcmp
+bool isPattern(const char* name) {
+    return strpbrk(name, "*?[") != NULL;
+}
+
+// Create every name in arg under cwd. The sibling list is scanned once to
+// find existing names and the tail, then new nodes are appended in order.
+void createBatch(const char* arg, bool isDirectory) {
+    const char* kind = isDirectory ? "Directory" : "File";
+    char buf[MAX_INPUT];
+    strncpy(buf, arg ? arg : "", MAX_INPUT - 1);
+    buf[MAX_INPUT - 1] = '\0';
+    char* names[MAX_ARGS];
+    int count = splitNames(buf, names, MAX_ARGS);
+    if (count == 0) {
+        printf("Error: %s name is empty.\n", kind);
         return;
     }
-    if (findChild(cwd, name)) {
-        printf("File already exists.\n");
-        return;
+
+    bool exists[MAX_ARGS] = { false };
+    Node* tail = NULL;
+    for (Node* temp = cwd->child; temp; temp = temp->sibling) {
+        for (int i = 0; i < count; i++) {
+            if (!exists[i] && strcmp(temp->name, names[i]) == 0) exists[i] = true;
+        }
+        tail = temp;
     }
-    Node* newFile = createNode(name, false);
-    if (newFile) {
-        insertChild(cwd, newFile);
-        if (verbose) printf("Created file: %s\n", name);
+
+    for (int i = 0; i < count; i++) {
+        // A name repeated on the command line exists once its first copy is created
+        for (int j = 0; j < i && !exists[i]; j++) {
+            if (strcmp(names[j], names[i]) == 0) exists[i] = true;
+        }
+        if (exists[i]) {
+            printf("%s %s already exists.\n", kind, names[i]);
+            continue;
+        }
+        Node* node = createNode(names[i], isDirectory);
+        if (!node && memExceeded) {
+            printf("%d of %d names not created: memory budget exceeded.\n", count - i, count);
+            return;
+        }
+        if (!node) continue;
+        appendChild(cwd, tail, node);
+        tail = node;
+        if (verbose) printf("Created %s: %s\n", isDirectory ? "directory" : "file", names[i]);
     }
 }
 
-void rmdir(const char* name) {
-    if (!name || strlen(name) == 0) {
-        printf("Error: Directory name is empty.\n");
-        return;
-    }
-    if (strcmp(name, "/") == 0) {
-        printf("Error: Cannot remove root directory.\n");
-        return;
-    }
-    Node* dir = findChild(cwd, name);
-    if (!dir) {
-        printf("No such directory.\n");
+// Remove every child of cwd matching a name or glob pattern in arg. The sibling
+// list is swept once; matches are unlinked onto a local list and freed together.
+void removeBatch(const char* arg, bool isDirectory) {
+    const char* kind = isDirectory ? "Directory" : "File";
+    char buf[MAX_INPUT];
+    strncpy(buf, arg ? arg : "", MAX_INPUT - 1);
+    buf[MAX_INPUT - 1] = '\0';
+    char* names[MAX_ARGS];
+    int count = splitNames(buf, names, MAX_ARGS);
+    if (count == 0) {
+        printf("Error: %s name is empty.\n", kind);
         return;
     }
-    if (!dir->isDirectory) {
-        printf("Error: %s is not a directory.\n", name);
-        return;
+
+    bool pattern[MAX_ARGS];
+    bool matched[MAX_ARGS] = { false };
+    for (int i = 0; i < count; i++) {
+        pattern[i] = isPattern(names[i]);
+        if (isDirectory && strcmp(names[i], "/") == 0) {
+            printf("Error: Cannot remove root directory.\n");
+            matched[i] = true;
+        }
     }
-    if (dir->child) {
-        printf("Error: Directory %s is not empty.\n", name);
-        return;
+
+    Node* doomed = NULL;
+    Node** link = &cwd->child;
+    while (*link) {
+        Node* node = *link;
+        // Every argument naming this node is credited, not only the first
+        bool hits[MAX_ARGS];
+        bool any = false;
+        bool literal = false;
+        for (int i = 0; i < count; i++) {
+            // A pattern also hits a name that is literally equal to it, such as a[1]
+            if (pattern[i]) hits[i] = strcmp(names[i], node->name) == 0 || fnmatch(names[i], node->name, FNM_PERIOD) == 0;
+            else hits[i] = !matched[i] && strcmp(names[i], node->name) == 0;
+            if (!hits[i]) continue;
+            any = true;
+            if (!pattern[i]) {
+                matched[i] = true;
+                literal = true;
+            }
+        }
+        if (!any) {
+            link = &node->sibling;
+            continue;
+        }
+        // Patterns silently skip entries of the wrong kind; literal names report them
+        if (node->isDirectory != isDirectory) {
+            if (literal) {
+                printf("Error: %s %s a directory.\n", node->name, isDirectory ? "is not" : "is");
+            }
+            link = &node->sibling;
+            continue;
+        }
+        for (int i = 0; i < count; i++) {
+            if (hits[i]) matched[i] = true;
+        }
+        if (isDirectory && node->child) {
+            printf("Error: Directory %s is not empty.\n", node->name);
+            link = &node->sibling;
+            continue;
+        }
+        // Unlink the node and keep it for the batched free
+        *link = node->sibling;
+        node->sibling = doomed;
+        doomed = node;
+        if (verbose) printf("Removed %s: %s\n", isDirectory ? "directory" : "file", node->name);
     }
-    if (cwd == dir) {
-        printf("Error: Cannot remove current working directory.\n");
-        return;
+
+    for (int i = 0; i < count; i++) {
+        if (matched[i]) continue;
+        if (pattern[i]) printf("No match for %s.\n", names[i]);
+        else printf("No such %s.\n", isDirectory ? "directory" : "file");
     }
-    // Unlink the directory
-    if (cwd->child == dir) {
-        cwd->child = dir->sibling;
-    } else {
-        Node* prev = cwd->child;
-        while (prev && prev->sibling != dir) prev = prev->sibling;
-        if (prev) prev->sibling = dir->sibling;
+
+    while (doomed) {
+        Node* next = doomed->sibling;
+        destroyNode(doomed);
+        doomed = next;
     }
-    if (verbose) printf("Removed directory: %s\n", name);
-    free(dir);
+}
+
+void mkdir(const char* name) {
+    createBatch(name, true);
+}
+
+void createFile(const char* name) {
+    createBatch(name, false);
+}
+
+void rmdir(const char* name) {
+    removeBatch(name, true);
 }
 
 void rm(const char* name) {
-    if (!name || strlen(name) == 0) {
-        printf("Error: File name is empty.\n");
-        return;
-    }
-    Node* file = findChild(cwd, name);
-    if (!file) {
-        printf("No such file.\n");
-        return;
-    }
-    if (file->isDirectory) {
-        printf("Error: %s is a directory.\n", name);
-        return;
-    }
-    // Unlink the file
-    if (cwd->child == file) {
-        cwd->child = file->sibling;
-    } else {
-        Node* prev = cwd->child;
-        while (prev && prev->sibling != file) prev = prev->sibling;
-        if (prev) prev->sibling = file->sibling;
-    }
-    if (verbose) printf("Removed file: %s\n", name);
-    free(file);
+    removeBatch(name, false);
 }
 
 void ls() {
@@ -402,6 +535,12 @@ void save(const char* filename) {
     else printf("File system saved to %s.\n", filename);
 }
 
+// Drop a partially loaded tree and keep the current one
+void abandonReload(Node* partial) {
+    freeTree(partial);
+    printf("File system left unchanged.\n");
+}
+
 void reload(const char* filename) {
     if (!filename || strlen(filename) == 0) {
         printf("Error: Filename is empty.\n");
@@ -412,10 +551,9 @@ void reload(const char* filename) {
         printf("Error: Could not open file %s.\n", filename);
         return;
     }
-    // Free the old tree
-    freeTree(root);
-    root = NULL;
-    cwd = NULL;
+    // Build the new tree beside the old one and swap it in only on success.
+    // Both trees are charged while they coexist, so the budget is never exceeded.
+    Node* newRoot = NULL;
 
     char line[MAX_INPUT];
     Node* stack[MAX_PATH_LEN];
@@ -438,9 +576,7 @@ void reload(const char* filename) {
         if (depth % 2 != 0) {
             printf("Error at line %d: Invalid indentation: '%s'\n", lineNumber, trimmedLine);
             fclose(file);
-            freeTree(root);
-            root = createNode("/", true);
-            cwd = root;
+            abandonReload(newRoot);
             return;
         }
 
@@ -464,22 +600,21 @@ void reload(const char* filename) {
         if (verbose) printf("reload: Depth=%d, currentLevel=%d, stackTop=%d\n", depth, currentLevel, stackTop);
 
         // Initialize root if not set
-        if (!root) {
+        if (!newRoot) {
             if (!isDir) {
                 printf("Error at line %d: First entry must be a directory: '%s'\n", lineNumber, trimmedLine);
                 fclose(file);
-                root = createNode("/", true);
-                cwd = root;
+                abandonReload(newRoot);
                 return;
             }
-            root = createNode(normalizedName, true);
-            if (!root) {
+            newRoot = createNode(normalizedName, true);
+            if (!newRoot) {
                 fclose(file);
                 printf("Error: Failed to create new root.\n");
+                abandonReload(newRoot);
                 return;
             }
-            cwd = root;
-            stack[++stackTop] = root;
+            stack[++stackTop] = newRoot;
             if (verbose) printf("reload: Set new root to %s (stackTop=%d)\n", normalizedName, stackTop);
             continue;
         }
@@ -493,35 +628,38 @@ void reload(const char* filename) {
         if (stackTop >= MAX_PATH_LEN) {
             printf("Error at line %d: Stack overflow.\n", lineNumber);
             fclose(file);
-            freeTree(root);
-            root = createNode("/", true);
-            cwd = root;
+            abandonReload(newRoot);
             return;
         }
 
         Node* newNode = createNode(normalizedName, isDir);
         if (!newNode) {
             fclose(file);
-            freeTree(root);
-            root = createNode("/", true);
-            cwd = root;
+            abandonReload(newRoot);
             return;
         }
         if (verbose) printf("reload: Adding %s (isDir=%d) at level %d, parent=%s\n", normalizedName, isDir, currentLevel, stack[stackTop-1]->name);
         insertChild(stack[stackTop-1], newNode);
         stack[stackTop] = newNode;
     }
+    fclose(file);
 
-    if (!root) {
-        root = createNode("/", true);
-        cwd = root;
-        if (verbose) printf("reload: No valid entries found, using default /\n");
-        else printf("File system reloaded from %s.\n", filename);
-    } else {
-        if (verbose) printf("Reloaded file system from: %s\n", filename);
-        else printf("File system reloaded from %s.\n", filename);
+    bool empty = !newRoot;
+    if (empty) {
+        newRoot = createNode("/", true);
+        if (!newRoot) {
+            abandonReload(newRoot);
+            return;
+        }
     }
-    fclose(file);
+    Node* oldRoot = root;
+    root = newRoot;
+    cwd = root;
+    freeTree(oldRoot);
+
+    if (empty && verbose) printf("reload: No valid entries found, using default /\n");
+    else if (verbose) printf("Reloaded file system from: %s\n", filename);
+    else printf("File system reloaded from %s.\n", filename);
 }
 
 void rmsave(const char* filename) {
@@ -581,6 +719,72 @@ bool askToSave() {
     }
 }
 
+void memstat(const char* path) {
+    Node* start = cwd;
+    if (path && strlen(path) > 0) {
+        start = findNodeFromPath(path[0] == '/' ? root : cwd, path);
+        if (!start) {
+            printf("No such directory: %s.\n", path);
+            return;
+        }
+    }
+    MemStat total = { 0, 0, 0 };
+    measureSubtree(start, &total);
+    printf("%s: %zu directories, %zu files, %zu bytes\n",
+           path && strlen(path) > 0 ? path : ".", total.directories, total.files, total.bytes);
+    for (Node* temp = start->child; temp; temp = temp->sibling) {
+        MemStat stat = { 0, 0, 0 };
+        measureSubtree(temp, &stat);
+        printf("  %s%s  %zu bytes\n", temp->name, temp->isDirectory ? "/" : "", stat.bytes);
+    }
+    if (memLimit) printf("Total: %zu of %zu bytes used.\n", memUsed, memLimit);
+    else printf("Total: %zu bytes used (no limit).\n", memUsed);
+}
+
+void setMemLimit(const char* arg) {
+    if (!arg || strlen(arg) == 0) {
+        if (memLimit) printf("Memory limit: %zu bytes (%zu used).\n", memLimit, memUsed);
+        else printf("Memory limit: off (%zu bytes used).\n", memUsed);
+        return;
+    }
+    if (strcmp(arg, "off") == 0) {
+        memLimit = 0;
+        memTrimmed = false;
+        printf("Memory limit disabled.\n");
+        return;
+    }
+    if (!isdigit((unsigned char)arg[0])) {
+        printf("Error: Invalid argument. Use a byte count (optionally K, M or G) or 'off'.\n");
+        return;
+    }
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(arg, &end, 10);
+    int shift = 0;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': shift = 10; end++; break;
+        case 'M': shift = 20; end++; break;
+        case 'G': shift = 30; end++; break;
+    }
+    if (*end != '\0' || parsed == 0) {
+        printf("Error: Invalid argument. Use a byte count (optionally K, M or G) or 'off'.\n");
+        return;
+    }
+    if (errno == ERANGE || parsed > (unsigned long long)(SIZE_MAX >> shift)) {
+        printf("Error: Limit %s is too large.\n", arg);
+        return;
+    }
+    size_t value = (size_t)parsed << shift;
+    if (value < memUsed) {
+        printf("Error: Limit %zu is below current usage of %zu bytes.\n", value, memUsed);
+        return;
+    }
+    memLimit = value;
+    memTrimmed = false;
+    if (memUnderPressure(memUsed)) relieveMemoryPressure();
+    printf("Memory limit set to %zu bytes.\n", memLimit);
+}
+
 void setVerbose(const char* arg) {
     if (!arg || strlen(arg) == 0) {
         printf("Error: Specify 'on' or 'off'.\n");
@@ -608,14 +812,16 @@ void showPrompt() {
 void printMenu() {
     printf("menu\n        print out all commands\n");
     printf("verbose [on|off]\n        turn on/off verbose mode\n");
-    printf("mkdir pathname\n        create an empty directory\n");
-    printf("rmdir pathname\n        remove an empty directory\n");
+    printf("mkdir name...\n        create one or more empty directories\n");
+    printf("rmdir name|pattern...\n        remove empty directories by name or glob pattern (*, ?, [...]); escape a metacharacter with \\ to match it literally\n");
     printf("cd [pathname]\n        change directory\n");
     printf("ls\n        list files and directories in the working directory\n");
     printf("tree [pathname]\n        print out the file system tree from the specified path or current directory\n");
     printf("pwd\n        print working directory\n");
-    printf("create pathname\n        create a file\n");
-    printf("rm pathname\n        remove a file\n");
+    printf("create name...\n        create one or more files\n");
+    printf("rm name|pattern...\n        remove files by name or glob pattern (*, ?, [...]); escape a metacharacter with \\ to match it literally\n");
+    printf("memstat [pathname]\n        show memory used by the tree under the specified path or current directory\n");
+    printf("memlimit [bytes|off]\n        show or set the budget for bytes held by tree nodes, a logical count unrelated to RSS (K, M, G suffixes allowed);\n        reload needs room for the old and new trees together\n");
     printf("save [pathname]\n        save the file system structure into a file\n");
     printf("reload [pathname]\n        reload the file system structure from a file\n");
     printf("rmsave [pathname]\n        remove a saved file system file\n");
@@ -653,7 +859,9 @@ void executeCommand(const char* cmdLine) {
                 printf("No such directory: %s.\n", arg);
             }
         }
-    } else if (strcmp(cmd, "save") == 0) save(arg);
+    } else if (strcmp(cmd, "memstat") == 0) memstat(arg);
+    else if (strcmp(cmd, "memlimit") == 0) setMemLimit(arg);
+    else if (strcmp(cmd, "save") == 0) save(arg);
     else if (strcmp(cmd, "reload") == 0) reload(arg);
     else if (strcmp(cmd, "rmsave") == 0) rmsave(arg);
     else if (strcmp(cmd, "quit") == 0 || strcmp(cmd, "exit") == 0) {